@@ -9,11 +9,18 @@
 #ifndef EMMPMESH_EMESHOPTIMIZATION_EMESHOPTIMIZATION_H_
 #define EMMPMESH_EMESHOPTIMIZATION_EMESHOPTIMIZATION_H_
 
+// Define EMESHOPTIMIZATION_STATIC when building or linking the static library
+#if defined(EMESHOPTIMIZATION_STATIC)
+#define E_MESH_OPTIMIZATION_API
+#elif defined(_WIN32)
 #ifdef EMESHOPTIMIZATION_EXPORTS
 #define E_MESH_OPTIMIZATION_API _declspec(dllexport)
 #else
 #define E_MESH_OPTIMIZATION_API _declspec(dllimport)
 #endif
+#else
+#define E_MESH_OPTIMIZATION_API __attribute__((visibility("default")))
+#endif
 
 class EMOVertex;
 class EMORegion;
@@ -1,51 +1,543 @@
 #include "EMeshOptimization.h" // Include the header file of the EMeshOptimization object
+#include "SyntheticMeshGenerator.h"
 
 #include <iostream>
 #include <chrono>
 #include <string>
 #include <sstream>
 #include <iomanip>
+#include <fstream>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#include <thread>
+#include <atomic>
+#else
+#include <sys/resource.h>
+#endif // _WIN32
 #ifdef MSMPI
 #include <mpi.h>
 #endif // MSMPI
 
-void GeneralOpti()
+// Mesh quality statistics reported by EMeshOptimizationOutputsMeshQualityInformation, -1 means not reported
+struct MeshQualityReport
 {
+	long long elementCount = -1;	// The number of mesh elements
+	long long vertexCount = -1;		// The number of vertices
+	double averageQuality = -1.0;	// The average quality of the current triangulation
+	long long badElementCount = -1;	// The number of bad mesh elements
+};
+
+// Read the number that follows the first occurrence of label in text
+template <typename T>
+bool ParseValueAfterLabel(const std::string& text, const std::string& label, T& value)
+{
+	std::size_t position = text.find(label);
+	if (position == std::string::npos)
+		return false;
+	std::istringstream stream(text.substr(position + label.size()));
+	return static_cast<bool>(stream >> value);
+}
+
+// Redirect std::cout into another stream buffer for the lifetime of the object, so that std::cout is restored even if
+// the redirected code throws
+class CoutRedirect
+{
+public:
+	explicit CoutRedirect(std::streambuf* buffer) : coutBuffer_(std::cout.rdbuf(buffer)) {}
+	~CoutRedirect() { std::cout.rdbuf(coutBuffer_); }
+	CoutRedirect(const CoutRedirect&) = delete;
+	CoutRedirect& operator=(const CoutRedirect&) = delete;
+
+private:
+	std::streambuf* coutBuffer_;
+};
+
+// Query the mesh quality information as structured statistics, return 1 if every statistic was found.
+// The library only reports these statistics on std::cout, which it shares with this program through the
+// dynamic C++ runtime, so its output is captured and parsed. Set echo to keep the original output visible.
+int QueryMeshQualityInformation(EMeshOptimization* pEMeshOptimization, MeshQualityReport& report, bool echo = true)
+{
+	// Capture the output of the library
+	std::ostringstream captured;
+	{
+		CoutRedirect redirect(captured.rdbuf());
+		EMeshOptimizationOutputsMeshQualityInformation(pEMeshOptimization);
+	}
+
+	const std::string text = captured.str();
+	if (echo)
+		std::cout << text << std::flush;
+
+	// Parse the statistics
+	report = MeshQualityReport();
+	int found = 0;
+	found += ParseValueAfterLabel(text, "The number of Meshes is ", report.elementCount);
+	found += ParseValueAfterLabel(text, "the number of Vertices is ", report.vertexCount);
+	found += ParseValueAfterLabel(text, "The average quality of the current triangulation is ", report.averageQuality);
+	found += ParseValueAfterLabel(text, "The number of Bad Meshes is ", report.badElementCount);
+	return found == 4 ? 1 : 0;
+}
+
+// Output the change of the mesh quality statistics caused by the optimization
+void OutputsMeshQualityChange(const MeshQualityReport& before, const MeshQualityReport& after)
+{
+	std::cout << "\nThe average quality: " << before.averageQuality << " -> " << after.averageQuality << std::endl;
+	std::cout << "The number of Bad Meshes: " << before.badElementCount << " -> " << after.badElementCount << std::endl;
+}
+
+// Command line options of the test driver: -folder <folder> -filename <file name> -format <format>
+// -method GEPM|GEPMA|GEPMB|LS -K <count> -N <count> -report <file>
+// and the stopping criteria -time <seconds> -targetQuality <quality> -targetBad <count> -stagnation <passes> <tolerance>
+struct RunOptions
+{
+	std::string folder = "..\\mesh\\X-51";	// The folder path of the mesh file
+	std::string filename = "X-51_D1_bin";	// The file name of the mesh file
+	std::string format;						// TXT, TXTWithMoreInfo, BIN or BINWithMoreInfo, empty uses the default of the mode
+	std::string method = "GEPM";	// The mesh optimization algorithm
+	int K = 3;						// The whole optimization iteration count
+	int N = -1;						// The continuous iteration count for a single node, -1 uses the default of the algorithm
+	std::string reportPath;			// The timing report file, .csv for CSV and JSON otherwise, empty disables the report
+
+	// Stopping criteria, the run stops after K passes or as soon as any enabled criterion is met
+	double timeBudget = 0.0;				// The wall-clock budget of the optimization in seconds, 0 disables it
+	double targetAverageQuality = -1.0;		// The target average quality, negative disables it
+	long long targetBadElementCount = -1;	// The target number of bad mesh elements, negative disables it
+	int stagnationWindow = 0;				// Stop if the average quality improved less than stagnationTolerance over this many passes, 0 disables it
+	double stagnationTolerance = 1e-4;
+
+	// Benchmark mode: -bench <case file> -repeat <count> -baseline <file> -tolerance <fraction> -qualityTolerance <quality>
+	std::string benchCasesPath;			// The benchmark case file, empty runs the single optimization
+	int repeat = 1;						// The number of runs of every benchmark case
+	std::string baselinePath;			// The results of an earlier benchmark to compare with, empty disables the comparison
+	double tolerance = 0.1;				// The allowed relative increase of the optimization time
+	double qualityTolerance = 0.01;		// The allowed decrease of the average quality
+
+	// Synthetic mesh mode: -generate <folder> <filename> -elements <count> -perturbation <fraction> -seed <seed> -format TXT|TXTWithMoreInfo
+	std::string generateFolder;			// The folder of the synthetic mesh, given like the folder of an imported mesh
+	std::string generateFilename;		// The file name of the synthetic mesh, empty runs the optimization
+	long long elementCount = 1000000;	// The requested number of mesh elements
+	double perturbation = 0.3;			// The maximum offset of the interior vertices as a fraction of the cube edge length
+	unsigned long long seed = 1;		// The seed of the vertex perturbation
+
+	bool HasStoppingCriteria() const
+	{
+		return timeBudget > 0.0 || targetAverageQuality >= 0.0 || targetBadElementCount >= 0 || stagnationWindow > 0;
+	}
+};
+
+// Parse the command line options, return false on an unknown option, a missing value or an unknown algorithm
+bool ParseRunOptions(int argc, char* argv[], RunOptions& options)
+{
+	// The options of a single run, a benchmark case runs all K passes with the mesh file and the algorithm of the case file
+	const std::vector<std::string> singleRunOptions = { "-folder", "-filename", "-format", "-method", "-K", "-N",
+		"-time", "-targetQuality", "-targetBad", "-stagnation" };
+	std::string singleRunOption;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string option = argv[i];
+		if (i + 1 >= argc)
+		{
+			std::cout << "Missing value for the option " << option << std::endl;
+			return false;
+		}
+		const std::string value = argv[++i];
+		if (std::find(singleRunOptions.begin(), singleRunOptions.end(), option) != singleRunOptions.end())
+			singleRunOption = option;
+		if (option == "-folder")
+			options.folder = value;
+		else if (option == "-filename")
+			options.filename = value;
+		else if (option == "-method")
+			options.method = value;
+		else if (option == "-K")
+			options.K = std::atoi(value.c_str());
+		else if (option == "-N")
+			options.N = std::atoi(value.c_str());
+		else if (option == "-report")
+			options.reportPath = value;
+		else if (option == "-time")
+			options.timeBudget = std::atof(value.c_str());
+		else if (option == "-targetQuality")
+			options.targetAverageQuality = std::atof(value.c_str());
+		else if (option == "-targetBad")
+			options.targetBadElementCount = std::atoll(value.c_str());
+		else if (option == "-bench")
+			options.benchCasesPath = value;
+		else if (option == "-repeat")
+			options.repeat = std::max(1, std::atoi(value.c_str()));
+		else if (option == "-baseline")
+			options.baselinePath = value;
+		else if (option == "-tolerance")
+			options.tolerance = std::atof(value.c_str());
+		else if (option == "-qualityTolerance")
+			options.qualityTolerance = std::atof(value.c_str());
+		else if (option == "-generate")
+		{
+			if (i + 1 >= argc)
+			{
+				std::cout << "Missing file name for the option " << option << std::endl;
+				return false;
+			}
+			options.generateFolder = value;
+			options.generateFilename = argv[++i];
+		}
+		else if (option == "-elements")
+			options.elementCount = std::atoll(value.c_str());
+		else if (option == "-perturbation")
+			options.perturbation = std::atof(value.c_str());
+		else if (option == "-seed")
+			options.seed = std::strtoull(value.c_str(), NULL, 10);
+		else if (option == "-format")
+			options.format = value;
+		else if (option == "-stagnation")
+		{
+			if (i + 1 >= argc)
+			{
+				std::cout << "Missing tolerance for the option " << option << std::endl;
+				return false;
+			}
+			options.stagnationWindow = std::atoi(value.c_str());
+			options.stagnationTolerance = std::atof(argv[++i]);
+		}
+		else
+		{
+			std::cout << "Unknown option " << option << std::endl;
+			return false;
+		}
+	}
+
+	if (!options.benchCasesPath.empty() && !singleRunOption.empty())
+	{
+		std::cout << "The option " << singleRunOption << " is not used with -bench, the cases are set in the case file" << std::endl;
+		return false;
+	}
+
+	// Use the default N of the API function of the selected algorithm, LS has no N
+	if (options.method == "GEPM")
+		options.N = options.N < 0 ? 200 : options.N;
+	else if (options.method == "LS")
+		options.N = 0;
+	else if (options.method == "GEPMA")
+		options.N = options.N < 0 ? 5 : options.N;
+	else if (options.method == "GEPMB")
+		options.N = options.N < 0 ? 350 : options.N;
+	else
+	{
+		std::cout << "Unknown mesh optimization algorithm " << options.method << std::endl;
+		return false;
+	}
+
+	// The sample meshes are imported from BINWithMoreInfo files, synthetic meshes are written as TXTWithMoreInfo files
+	if (options.format.empty())
+		options.format = options.generateFilename.empty() ? "BINWithMoreInfo" : "TXTWithMoreInfo";
+
+#ifdef MSMPI
+	// The stopping criteria run the algorithm pass by pass, which the MS-MPI variants do not support
+	if (options.HasStoppingCriteria())
+	{
+		std::cout << "The stopping criteria are only supported by the single process optimization" << std::endl;
+		return false;
+	}
+#endif // MSMPI
+	return true;
+}
+
+// Run the selected mesh optimization algorithm, the MS-MPI variants are used when MSMPI is defined
+void RunOptimization(EMeshOptimization* pEMeshOptimization, const std::string& method, const int& K, const int& N)
+{
+#ifdef MSMPI
+	if (method == "GEPM")
+		EMeshOptimization_GEPM_MSMPI(pEMeshOptimization, K, N);
+	else if (method == "GEPMA")
+		EMeshOptimization_GEPMA_MSMPI(pEMeshOptimization, K, N);
+	else if (method == "GEPMB")
+		EMeshOptimization_GEPMB_MSMPI(pEMeshOptimization, K, N);
+	else if (method == "LS")
+		EMeshOptimization_LS_MSMPI(pEMeshOptimization, K);
+#else
+	if (method == "GEPM")
+		EMeshOptimization_GEPM(pEMeshOptimization, K, N);
+	else if (method == "GEPMA")
+		EMeshOptimization_GEPMA(pEMeshOptimization, K, N);
+	else if (method == "GEPMB")
+		EMeshOptimization_GEPMB(pEMeshOptimization, K, N);
+	else if (method == "LS")
+		EMeshOptimization_LS(pEMeshOptimization, K);
+#endif // MSMPI
+}
+
+// The path of the mesh file for a folder path and a file name, assumed to be the path the importers open: the folder and the
+// file name joined by the separator of the platform, without a file extension
+std::string MeshFilePath(const std::string& folder, const std::string& filename)
+{
+#ifdef _WIN32
+	const char separator = '\\';
+#else
+	const char separator = '/';
+#endif // _WIN32
+	if (folder.empty() || folder.back() == '/' || folder.back() == separator)
+		return folder + filename;
+	return folder + separator + filename;
+}
+
+// Import the mesh file with the importer of the given format, return 1 on success and 0 on failure
+int ImportMesh(EMeshOptimization* pEMeshOptimization, const std::string& format, const std::string& folder, const std::string& filename)
+{
+	if (format == "TXT")
+		return EMeshOptimizationInitialMeshImportFromTXT(pEMeshOptimization, folder, filename);
+	if (format == "TXTWithMoreInfo")
+		return EMeshOptimizationInitialMeshImportFromTXTWithMoreInfo(pEMeshOptimization, folder, filename);
+	if (format == "BIN")
+		return EMeshOptimizationInitialMeshImportFromBIN(pEMeshOptimization, folder, filename);
+	if (format == "BINWithMoreInfo")
+		return EMeshOptimizationInitialMeshImportFromBINWithMoreInfo(pEMeshOptimization, folder, filename);
+	std::cout << "Unknown mesh file format " << format << std::endl;
+	return 0;
+}
+
+// Wall-clock time of each phase of a run and the mesh quality around the optimization
+struct RunReport
+{
+	RunOptions options;
+	int processCount = 1;
+	std::vector<std::pair<std::string, double>> phaseSeconds;
+	std::vector<double> rankOptimizationSeconds;	// The time every MS-MPI process spent in the optimization call
+	std::vector<double> passSeconds;				// The time of every pass when the run uses stopping criteria
+	double passQualitySeconds = 0.0;				// The time of the quality checks between the passes
+	std::string stopReason;							// The criterion that stopped the optimization
+	MeshQualityReport initialQuality;
+	MeshQualityReport optimizedQuality;
+};
+
+// Seconds elapsed since start
+double SecondsSince(const std::chrono::steady_clock::time_point& start)
+{
+	std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - start;
+	return elapsedTime.count();
+}
+
+// Write the quality statistics as the members of a JSON object
+void WriteQualityJSON(std::ostream& out, const MeshQualityReport& quality)
+{
+	out << "{\"elementCount\": " << quality.elementCount
+		<< ", \"vertexCount\": " << quality.vertexCount
+		<< ", \"averageQuality\": " << quality.averageQuality
+		<< ", \"badElementCount\": " << quality.badElementCount << "}";
+}
+
+// Write the quality statistics as rows of a CSV file
+void WriteQualityCSV(std::ostream& out, const std::string& record, const MeshQualityReport& quality)
+{
+	out << record << ",elementCount," << quality.elementCount << "\n";
+	out << record << ",vertexCount," << quality.vertexCount << "\n";
+	out << record << ",averageQuality," << quality.averageQuality << "\n";
+	out << record << ",badElementCount," << quality.badElementCount << "\n";
+}
+
+// Write the run report to path, as CSV rows "record,name,value" if the path ends with .csv and as JSON otherwise.
+// Return 1 on success, 0 if the file could not be written.
+int WriteRunReport(const RunReport& report, const std::string& path)
+{
+	std::ofstream out(path);
+	if (!out)
+	{
+		std::cout << "The report file could not be opened for writing." << std::endl;
+		return 0;
+	}
+	out << std::setprecision(9);
+
+	// The ratio between the slowest and the average process shows the load imbalance of MS-MPI runs
+	double imbalance = 1.0;
+	if (!report.rankOptimizationSeconds.empty())
+	{
+		double sum = 0.0;
+		for (double seconds : report.rankOptimizationSeconds)
+			sum += seconds;
+		double maximum = *std::max_element(report.rankOptimizationSeconds.begin(), report.rankOptimizationSeconds.end());
+		if (sum > 0.0)
+			imbalance = maximum * report.rankOptimizationSeconds.size() / sum;
+	}
+
+	const bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+	if (csv)
+	{
+		out << "record,name,value\n";
+		out << "run,method," << report.options.method << "\n";
+		out << "run,K," << report.options.K << "\n";
+		out << "run,N," << report.options.N << "\n";
+		out << "run,processCount," << report.processCount << "\n";
+		for (const auto& phase : report.phaseSeconds)
+			out << "phase," << phase.first << "," << phase.second << "\n";
+		for (std::size_t rank = 0; rank < report.rankOptimizationSeconds.size(); ++rank)
+			out << "rank," << rank << "," << report.rankOptimizationSeconds[rank] << "\n";
+		out << "run,rankImbalance," << imbalance << "\n";
+		for (std::size_t pass = 0; pass < report.passSeconds.size(); ++pass)
+			out << "pass," << pass << "," << report.passSeconds[pass] << "\n";
+		out << "run,stopReason," << report.stopReason << "\n";
+		WriteQualityCSV(out, "initialQuality", report.initialQuality);
+		WriteQualityCSV(out, "optimizedQuality", report.optimizedQuality);
+	}
+	else
+	{
+		out << "{\n";
+		out << "  \"method\": \"" << report.options.method << "\",\n";
+		out << "  \"K\": " << report.options.K << ",\n";
+		out << "  \"N\": " << report.options.N << ",\n";
+		out << "  \"processCount\": " << report.processCount << ",\n";
+		out << "  \"phaseSeconds\": {";
+		for (std::size_t i = 0; i < report.phaseSeconds.size(); ++i)
+			out << (i == 0 ? "" : ", ") << "\"" << report.phaseSeconds[i].first << "\": " << report.phaseSeconds[i].second;
+		out << "},\n";
+		out << "  \"rankOptimizationSeconds\": [";
+		for (std::size_t rank = 0; rank < report.rankOptimizationSeconds.size(); ++rank)
+			out << (rank == 0 ? "" : ", ") << report.rankOptimizationSeconds[rank];
+		out << "],\n";
+		out << "  \"rankImbalance\": " << imbalance << ",\n";
+		out << "  \"passSeconds\": [";
+		for (std::size_t pass = 0; pass < report.passSeconds.size(); ++pass)
+			out << (pass == 0 ? "" : ", ") << report.passSeconds[pass];
+		out << "],\n";
+		out << "  \"stopReason\": \"" << report.stopReason << "\",\n";
+		out << "  \"initialQuality\": ";
+		WriteQualityJSON(out, report.initialQuality);
+		out << ",\n  \"optimizedQuality\": ";
+		WriteQualityJSON(out, report.optimizedQuality);
+		out << "\n}\n";
+	}
+	return out ? 1 : 0;
+}
+
+// Return the name of the quality criterion met by quality, or an empty string if none is met
+std::string QualityCriterionMet(const RunOptions& options, const MeshQualityReport& quality)
+{
+	if (options.targetAverageQuality >= 0.0 && quality.averageQuality >= options.targetAverageQuality)
+		return "targetQuality";
+	if (options.targetBadElementCount >= 0 && quality.badElementCount >= 0 && quality.badElementCount <= options.targetBadElementCount)
+		return "targetBad";
+	return "";
+}
+
+// Run the selected algorithm one pass (K = 1) at a time, check the stopping criteria after every pass and return the
+// name of the criterion that stopped the run, "K" if all passes were run. The time budget also stops the run before a
+// pass that is expected to exceed it, because a running pass of the library cannot be interrupted. The quality criteria
+// stop the run with "qualityUnavailable" if the quality statistics of the library cannot be parsed. The time of the
+// quality checks is accumulated in report.passQualitySeconds.
+std::string RunOptimizationWithStoppingCriteria(EMeshOptimization* pEMeshOptimization, const RunOptions& options, const MeshQualityReport& initialQuality, const bool& initialQualityAvailable, RunReport& report)
+{
+	const bool qualityCriteria = options.targetAverageQuality >= 0.0 || options.targetBadElementCount >= 0 || options.stagnationWindow > 0;
+	if (qualityCriteria && !initialQualityAvailable)
+		return "qualityUnavailable";
+	std::string criterion = QualityCriterionMet(options, initialQuality);
+	if (!criterion.empty())
+		return criterion;
+
+	auto start = std::chrono::steady_clock::now();
+	std::vector<double> averageQualities(1, initialQuality.averageQuality);
+	double longestPass = 0.0;
+	for (int pass = 0; pass < options.K; ++pass)
+	{
+		// Run one pass and record its time
+		auto passStart = std::chrono::steady_clock::now();
+		RunOptimization(pEMeshOptimization, options.method, 1, options.N);
+		report.passSeconds.push_back(SecondsSince(passStart));
+		longestPass = std::max(longestPass, report.passSeconds.back());
+
+		// Check the quality targets
+		MeshQualityReport quality;
+		auto qualityStart = std::chrono::steady_clock::now();
+		const bool qualityAvailable = QueryMeshQualityInformation(pEMeshOptimization, quality, false) == 1;
+		report.passQualitySeconds += SecondsSince(qualityStart);
+		std::cout << "Pass " << pass + 1 << ": " << report.passSeconds.back() << " s, the average quality is " << quality.averageQuality
+			<< ", the number of Bad Meshes is " << quality.badElementCount << std::endl;
+		if (qualityCriteria && !qualityAvailable)
+			return "qualityUnavailable";
+		criterion = QualityCriterionMet(options, quality);
+		if (!criterion.empty())
+			return criterion;
+
+		// Check the stagnation of the average quality
+		averageQualities.push_back(quality.averageQuality);
+		if (options.stagnationWindow > 0 && static_cast<int>(averageQualities.size()) > options.stagnationWindow)
+		{
+			double improvement = averageQualities.back() - averageQualities[averageQualities.size() - 1 - options.stagnationWindow];
+			if (improvement < options.stagnationTolerance)
+				return "stagnation";
+		}
+
+		// Check the time budget
+		double elapsed = SecondsSince(start);
+		if (options.timeBudget > 0.0 && pass + 1 < options.K && elapsed + longestPass > options.timeBudget)
+			return "time";
+	}
+	return "K";
+}
+
+// Single process optimization, return 0 on success and 1 if the mesh could not be imported
+int GeneralOpti(const RunOptions& options)
+{
+	// Record the run report
+	RunReport report;
+	report.options = options;
+	auto phaseStart = std::chrono::steady_clock::now();
+
 	// Create a new EMeshOptimization object
 	EMeshOptimization* pEMeshOptimization = NULL;
 	pEMeshOptimization = EMeshOptimizationNew();
 
 	// Set the parameters of the EMeshOptimization object
-	if (EMeshOptimizationInitialMeshImportFromBINWithMoreInfo(pEMeshOptimization, "..\\mesh\\X-51", "X-51_D1_bin") != 1)
-		return;
-	//if (EMeshOptimizationInitialMeshImportFromBINWithMoreInfo(pEMeshOptimization, "..\\mesh\\R60", "R60_D1_bin") != 1)
-	//	return 0;
+	if (ImportMesh(pEMeshOptimization, options.format, options.folder, options.filename) != 1)
+	{
+		EMeshOptimizationDelete(pEMeshOptimization);
+		return 1;
+	}
+	report.phaseSeconds.emplace_back("import", SecondsSince(phaseStart));
 
 	// Output the mesh quality information of the initial mesh
 	std::cout << "\nThe mesh info before optimized:\n";
-	EMeshOptimizationOutputsMeshQualityInformation(pEMeshOptimization);
+	phaseStart = std::chrono::steady_clock::now();
+	const bool initialQualityAvailable = QueryMeshQualityInformation(pEMeshOptimization, report.initialQuality) == 1;
+	report.phaseSeconds.emplace_back("initialQuality", SecondsSince(phaseStart));
 
 	// Record the start time of the mesh optimization algorithm
 	std::cout << "\nOptimization start..." << std::endl;
 	auto start = std::chrono::steady_clock::now();
 
 	// Run the mesh optimization algorithm
-	EMeshOptimization_GEPM(pEMeshOptimization);
-	//EMeshOptimization_GEPMA(pEMeshOptimization);
-	//EMeshOptimization_GEPMB(pEMeshOptimization);
-	//EMeshOptimization_LS(pEMeshOptimization);
+	if (options.HasStoppingCriteria())
+		report.stopReason = RunOptimizationWithStoppingCriteria(pEMeshOptimization, options, report.initialQuality, initialQualityAvailable, report);
+	else
+	{
+		RunOptimization(pEMeshOptimization, options.method, options.K, options.N);
+		report.stopReason = "K";
+	}
 
 	// Record the end time of the mesh optimization algorithm
 	auto end = std::chrono::steady_clock::now();
-	std::cout << "Optimization end!" << std::endl;
+	std::cout << "Optimization end! Stopped by: " << report.stopReason << std::endl;
 
-	// Output the time cost of the mesh optimization algorithm, use seconds as the unit
+	// Output the time cost of the mesh optimization algorithm without the quality checks between the passes, use seconds as the unit
 	std::chrono::duration<double> elapsedTime = end - start;
-	std::cout << "\nThe time cost of the mesh optimization algorithm: " << elapsedTime.count() << " s" << std::endl;
+	std::cout << "\nThe time cost of the mesh optimization algorithm: " << elapsedTime.count() - report.passQualitySeconds << " s" << std::endl;
+	report.phaseSeconds.emplace_back("optimization", elapsedTime.count() - report.passQualitySeconds);
+	if (options.HasStoppingCriteria())
+	{
+		std::cout << "The time cost of the quality checks between the passes: " << report.passQualitySeconds << " s" << std::endl;
+		report.phaseSeconds.emplace_back("passQuality", report.passQualitySeconds);
+	}
 
 	// Output the mesh quality information of the optimized mesh
 	std::cout << "\nThe mesh info after optimized:\n";
-	EMeshOptimizationOutputsMeshQualityInformation(pEMeshOptimization);
+	phaseStart = std::chrono::steady_clock::now();
+	QueryMeshQualityInformation(pEMeshOptimization, report.optimizedQuality);
+	report.phaseSeconds.emplace_back("optimizedQuality", SecondsSince(phaseStart));
+	OutputsMeshQualityChange(report.initialQuality, report.optimizedQuality);
 
 	// Export the optimized mesh to a TXT file
 	//if (EMeshOptimizationExportOptimizedMeshToTXT(pEMeshOptimization, "..\\mesh\\result\\X-51", "X-51_D1_OUT") != 1)
@@ -53,11 +545,17 @@ void GeneralOpti()
 	//if (EMeshOptimizationExportOptimizedMeshToTXT(pEMeshOptimization, "..\\mesh\\result\\R60", "R60_D1_OUT") != 1)
 	//	return 0;
 
+	// Write the run report
+	if (!options.reportPath.empty())
+		WriteRunReport(report, options.reportPath);
+
 	// Delete the EMeshOptimization object
 	EMeshOptimizationDelete(pEMeshOptimization);
+	return 0;
 }
 
-void MSMPIOpti()
+// MPI optimization, return 0 on success and 1 on every process if the mesh could not be imported
+int MSMPIOpti(const RunOptions& options)
 {
 #ifdef MSMPI
 	// Get the rank and size of the MPI process
@@ -65,6 +563,12 @@ void MSMPIOpti()
 	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
 	MPI_Comm_size(MPI_COMM_WORLD, &size);
 
+	// Record the run report
+	RunReport report;
+	report.options = options;
+	report.processCount = size;
+	auto phaseStart = std::chrono::steady_clock::now();
+
 	// Record the start and end time of the mesh optimization algorithm
 	auto start_opti = std::chrono::steady_clock::now();
 	auto end_opti = std::chrono::steady_clock::now();
@@ -72,22 +576,34 @@ void MSMPIOpti()
 	// Create a new EMeshOptimization object
 	EMeshOptimization* pEMeshOptimization = NULL;
 	pEMeshOptimization = EMeshOptimizationNew();
+
+	// Set the parameters of the EMeshOptimization object on rank 0 and tell the other processes whether it succeeded
+	int imported = 1;
 	if (rank == 0)
+		imported = ImportMesh(pEMeshOptimization, options.format, options.folder, options.filename);
+	MPI_Bcast(&imported, 1, MPI_INT, 0, MPI_COMM_WORLD);
+	if (imported != 1)
 	{
-		// Set the parameters of the EMeshOptimization object
-		if (EMeshOptimizationInitialMeshImportFromBINWithMoreInfo(pEMeshOptimization, "..\\mesh\\X-51", "X-51_D1_bin") != 1)
-			return;
-		//if (EMeshOptimizationInitialMeshImportFromBINWithMoreInfo(pEMeshOptimization, "..\\mesh\\R60", "R60_D1_bin") != 1)
-		//	return 0;
+		EMeshOptimizationDelete(pEMeshOptimization);
+		return 1;
+	}
+
+	if (rank == 0)
+	{
+		report.phaseSeconds.emplace_back("import", SecondsSince(phaseStart));
 
 		// Output the mesh quality information of the initial mesh
 		std::cout << "\nThe mesh info before optimized:\n";
-		EMeshOptimizationOutputsMeshQualityInformation(pEMeshOptimization);
+		phaseStart = std::chrono::steady_clock::now();
+		QueryMeshQualityInformation(pEMeshOptimization, report.initialQuality);
+		report.phaseSeconds.emplace_back("initialQuality", SecondsSince(phaseStart));
 
 		// Domain decomposition
 		std::cout << "\nDomain decomposition start..." << std::endl;
 		std::cout << "Current number of partitions: " << size << std::endl;
+		phaseStart = std::chrono::steady_clock::now();
 		EMeshOptimizationDomainDecomposition(pEMeshOptimization);
+		report.phaseSeconds.emplace_back("decomposition", SecondsSince(phaseStart));
 		std::cout << "Domain decomposition end!" << std::endl;
 
 		// Record the start time of the mesh optimization algorithm
@@ -96,10 +612,18 @@ void MSMPIOpti()
 	}
 
 	// Run the mesh optimization algorithm
-	EMeshOptimization_GEPM_MSMPI(pEMeshOptimization);
-	//EMeshOptimization_GEPMA_MSMPI(pEMeshOptimization);
-	//EMeshOptimization_GEPMB_MSMPI(pEMeshOptimization);
-	//EMeshOptimization_LS_MSMPI(pEMeshOptimization);
+	auto rankStart = std::chrono::steady_clock::now();
+	RunOptimization(pEMeshOptimization, options.method, options.K, options.N);
+	double rankSeconds = SecondsSince(rankStart);
+	report.stopReason = "K";
+
+	// Collect the time every process spent in the optimization call
+	if (!options.reportPath.empty())
+	{
+		if (rank == 0)
+			report.rankOptimizationSeconds.resize(size);
+		MPI_Gather(&rankSeconds, 1, MPI_DOUBLE, report.rankOptimizationSeconds.data(), 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+	}
 
 	if (rank == 0)
 	{
@@ -110,21 +634,470 @@ void MSMPIOpti()
 		// Output the time cost of the mesh optimization algorithm, use seconds as the unit
 		std::chrono::duration<double> elapsedTime = end_opti - start_opti;
 		std::cout << "\nThe time cost of the mesh optimization algorithm: " << elapsedTime.count() << " s" << std::endl;
+		report.phaseSeconds.emplace_back("optimization", elapsedTime.count());
 
 		// Output the mesh quality information of the optimized mesh
 		std::cout << "\nThe mesh info after optimized:\n";
-		EMeshOptimizationOutputsMeshQualityInformation(pEMeshOptimization);
+		phaseStart = std::chrono::steady_clock::now();
+		QueryMeshQualityInformation(pEMeshOptimization, report.optimizedQuality);
+		report.phaseSeconds.emplace_back("optimizedQuality", SecondsSince(phaseStart));
+		OutputsMeshQualityChange(report.initialQuality, report.optimizedQuality);
 
 		// Export the optimized mesh to a TXT file
 		//if (EMeshOptimizationExportOptimizedMeshToTXT(pEMeshOptimization, "..\\mesh\\result\\X-51", "X-51_D1_OUT") != 1)
 		//    return 0;
 		//if (EMeshOptimizationExportOptimizedMeshToTXT(pEMeshOptimization, "..\\mesh\\result\\R60", "R60_D1_OUT") != 1)
 		//	return 0;
+
+		// Write the run report
+		if (!options.reportPath.empty())
+			WriteRunReport(report, options.reportPath);
 	}
 
 	// Delete the EMeshOptimization object
 	EMeshOptimizationDelete(pEMeshOptimization);
+	return 0;
+#else
+	(void)options;
+	return 0;
+#endif // MSMPI
+}
+
+// Generate a synthetic mesh and write it for the TXT importer selected by options.format, return 0 on success and 1 on failure
+int GenerateSyntheticMesh(const RunOptions& options)
+{
+	if (options.format != "TXT" && options.format != "TXTWithMoreInfo")
+	{
+		std::cout << "The synthetic mesh can only be written in the TXT or TXTWithMoreInfo format" << std::endl;
+		return 1;
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	SyntheticMeshGenerator generator(options.elementCount);
+	generator.PerturbInteriorVertices(options.perturbation, options.seed);
+	// Write the file the importers are assumed to open for the same folder path and file name
+	const std::string path = MeshFilePath(options.generateFolder, options.generateFilename);
+	if (generator.ExportToTXT(path, options.format == "TXTWithMoreInfo") != 1)
+	{
+		std::cout << "The mesh file could not be opened for writing." << std::endl;
+		return 1;
+	}
+	std::cout << "The synthetic mesh " << path << " has " << generator.VertexCount() << " vertices and "
+		<< generator.ElementCount() << " mesh elements, generated in " << SecondsSince(start) << " s" << std::endl;
+	return 0;
+}
+
+// A benchmark case: the mesh file and the settings of the mesh optimization algorithm
+struct BenchmarkCase
+{
+	std::string name;		// The mesh name used in the case ID
+	std::string folder;		// The folder path of the mesh file
+	std::string filename;	// The file name of the mesh file
+	std::string format;		// TXT, TXTWithMoreInfo, BIN or BINWithMoreInfo
+	std::string method;		// GEPM, GEPMA, GEPMB or LS
+	int K = 3;
+	int N = 0;
+	long long elementCount = 0;	// The element count of a synthetic mesh written if the mesh file is missing, 0 for other meshes
+
+	std::string ID(int processCount) const
+	{
+		return name + "/" + method + "/K" + std::to_string(K) + "/N" + std::to_string(N) + "/P" + std::to_string(processCount);
+	}
+};
+
+// One measured run of a benchmark case
+struct BenchmarkResult
+{
+	std::string caseID;
+	int repeat = 0;
+	double importSeconds = 0.0;
+	double wallSeconds = 0.0;				// The time of the optimization
+	double vertexUpdatesPerSecond = 0.0;	// The number of vertices times K divided by the time of the optimization
+	long long peakRSSBytes = -1;			// The peak resident set size during this run, -1 if it cannot be measured per case
+	MeshQualityReport quality;				// The mesh quality after the optimization
+};
+
+// The summary of all runs of a benchmark case, used for the comparison with a baseline
+struct BenchmarkSummary
+{
+	double bestWallSeconds = 0.0;
+	double meanAverageQuality = 0.0;
+	int runCount = 0;
+
+	void Add(double wallSeconds, double averageQuality)
+	{
+		bestWallSeconds = runCount == 0 ? wallSeconds : std::min(bestWallSeconds, wallSeconds);
+		meanAverageQuality = (meanAverageQuality * runCount + averageQuality) / (runCount + 1);
+		++runCount;
+	}
+};
+
+// Read the benchmark cases, one case per line: name folder filename format method K N [elements].
+// Empty lines and lines starting with # are skipped. Return false if the file cannot be read or a line is malformed.
+bool ReadBenchmarkCases(const std::string& path, std::vector<BenchmarkCase>& cases)
+{
+	std::ifstream in(path);
+	if (!in)
+	{
+		std::cout << "The benchmark case file could not be opened successfully." << std::endl;
+		return false;
+	}
+
+	std::string line;
+	for (int lineNumber = 1; std::getline(in, line); ++lineNumber)
+	{
+		std::istringstream stream(line);
+		BenchmarkCase benchmarkCase;
+		if (!(stream >> benchmarkCase.name) || benchmarkCase.name[0] == '#')
+			continue;
+		if (!(stream >> benchmarkCase.folder >> benchmarkCase.filename >> benchmarkCase.format >> benchmarkCase.method >> benchmarkCase.K >> benchmarkCase.N))
+		{
+			std::cout << "Malformed benchmark case at line " << lineNumber << " of " << path << std::endl;
+			return false;
+		}
+		if (!(stream >> benchmarkCase.elementCount))
+			benchmarkCase.elementCount = 0;
+		cases.push_back(benchmarkCase);
+	}
+	return true;
+}
+
+// The peak resident set size of the process in bytes, since the start or since the last ResetPeakResidentSetSize
+long long PeakResidentSetSize()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return static_cast<long long>(counters.PeakWorkingSetSize);
+	return 0;
+#else
+#ifdef __linux__
+	// VmHWM follows the resets through /proc/self/clear_refs, ru_maxrss does not
+	std::ifstream status("/proc/self/status");
+	std::string line;
+	while (std::getline(status, line))
+	{
+		if (line.compare(0, 6, "VmHWM:") == 0)
+			return std::atoll(line.c_str() + 6) * 1024;
+	}
+#endif // __linux__
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0)
+		return static_cast<long long>(usage.ru_maxrss) * 1024;
+	return 0;
+#endif // _WIN32
+}
+
+// Reset the peak resident set size to the current one, return false where the platform does not support it
+bool ResetPeakResidentSetSize()
+{
+#ifdef __linux__
+	std::ofstream clearRefs("/proc/self/clear_refs");
+	clearRefs << "5";
+	clearRefs.flush();
+	return static_cast<bool>(clearRefs);
+#else
+	return false;
+#endif // __linux__
+}
+
+// Measure the peak resident set size of the process between Start and Stop. Where the peak can be reset, Start resets it.
+// Windows keeps the peak of the whole process, so the working set is also sampled while the monitor runs: the peak of the
+// process is exact when it was raised after Start, otherwise the largest sample is used.
+class PeakMemoryMonitor
+{
+public:
+	PeakMemoryMonitor() = default;
+	~PeakMemoryMonitor() { Stop(); }
+	PeakMemoryMonitor(const PeakMemoryMonitor&) = delete;
+	PeakMemoryMonitor& operator=(const PeakMemoryMonitor&) = delete;
+
+	void Start()
+	{
+		Stop();
+		reset_ = ResetPeakResidentSetSize();
+		startPeak_ = PeakResidentSetSize();
+#ifdef _WIN32
+		sampledPeak_ = 0;
+		running_ = true;
+		sampler_ = std::thread([this]() {
+			while (running_)
+			{
+				PROCESS_MEMORY_COUNTERS counters;
+				if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+				{
+					long long workingSet = static_cast<long long>(counters.WorkingSetSize);
+					if (workingSet > sampledPeak_)
+						sampledPeak_ = workingSet;
+				}
+				Sleep(kSampleMilliseconds);
+			}
+		});
+#endif // _WIN32
+	}
+
+	// Return the peak in bytes, -1 if the platform can neither reset nor sample it
+	long long Stop()
+	{
+#ifdef _WIN32
+		if (sampler_.joinable())
+		{
+			running_ = false;
+			sampler_.join();
+			long long peak = PeakResidentSetSize();
+			return peak > startPeak_ ? peak : static_cast<long long>(sampledPeak_);
+		}
+		return -1;
+#else
+		return reset_ ? PeakResidentSetSize() : -1;
+#endif // _WIN32
+	}
+
+private:
+	bool reset_ = false;
+	long long startPeak_ = 0;
+#ifdef _WIN32
+	static const DWORD kSampleMilliseconds = 5;
+	std::atomic<bool> running_{ false };
+	std::atomic<long long> sampledPeak_{ 0 };
+	std::thread sampler_;
+#endif // _WIN32
+};
+
+// Run a benchmark case once, the results are only valid on rank 0. Return 1 on success, 0 if the mesh could not be imported
+// and -1 if the mesh quality could not be read on rank 0.
+int RunBenchmarkCase(const BenchmarkCase& benchmarkCase, int rank, int size, BenchmarkResult& result)
+{
+	EMeshOptimization* pEMeshOptimization = NULL;
+	pEMeshOptimization = EMeshOptimizationNew();
+
+	// Import the mesh on rank 0, the other processes receive their partitions from it
+	int imported = 1;
+	PeakMemoryMonitor peakMemory;
+	if (rank == 0)
+	{
+		peakMemory.Start();
+		auto importStart = std::chrono::steady_clock::now();
+		imported = ImportMesh(pEMeshOptimization, benchmarkCase.format, benchmarkCase.folder, benchmarkCase.filename);
+		result.importSeconds = SecondsSince(importStart);
+#ifdef MSMPI
+		if (imported == 1)
+			EMeshOptimizationDomainDecomposition(pEMeshOptimization);
+#endif // MSMPI
+	}
+#ifdef MSMPI
+	MPI_Bcast(&imported, 1, MPI_INT, 0, MPI_COMM_WORLD);
+#endif // MSMPI
+	if (imported != 1)
+	{
+		EMeshOptimizationDelete(pEMeshOptimization);
+		return 0;
+	}
+
+	// Run the mesh optimization algorithm
+	auto start = std::chrono::steady_clock::now();
+	RunOptimization(pEMeshOptimization, benchmarkCase.method, benchmarkCase.K, benchmarkCase.N);
+	result.wallSeconds = SecondsSince(start);
+
+	// Record the mesh quality and the throughput
+	int status = 1;
+	if (rank == 0)
+	{
+		result.caseID = benchmarkCase.ID(size);
+		if (QueryMeshQualityInformation(pEMeshOptimization, result.quality, false) != 1)
+			status = -1;
+		if (result.wallSeconds > 0.0 && result.quality.vertexCount > 0)
+			result.vertexUpdatesPerSecond = static_cast<double>(result.quality.vertexCount) * benchmarkCase.K / result.wallSeconds;
+		result.peakRSSBytes = peakMemory.Stop();
+	}
+
+	EMeshOptimizationDelete(pEMeshOptimization);
+	return status;
+}
+
+// Write the benchmark results as JSON with one result object per line, the format read by ReadBenchmarkBaseline
+int WriteBenchmarkResults(const std::vector<BenchmarkResult>& results, int processCount, long long processPeakRSSBytes, const std::string& path)
+{
+	std::ofstream out(path);
+	if (!out)
+	{
+		std::cout << "The benchmark result file could not be opened for writing." << std::endl;
+		return 0;
+	}
+	out << std::setprecision(9);
+	out << "{\n";
+	out << "  \"processCount\": " << processCount << ",\n";
+	out << "  \"processPeakRSSBytes\": " << processPeakRSSBytes << ",\n";
+	out << "  \"results\": [\n";
+	for (std::size_t i = 0; i < results.size(); ++i)
+	{
+		const BenchmarkResult& result = results[i];
+		out << "    {\"case\": \"" << result.caseID << "\""
+			<< ", \"repeat\": " << result.repeat
+			<< ", \"importSeconds\": " << result.importSeconds
+			<< ", \"wallSeconds\": " << result.wallSeconds
+			<< ", \"vertexUpdatesPerSecond\": " << result.vertexUpdatesPerSecond
+			<< ", \"peakRSSBytes\": " << result.peakRSSBytes
+			<< ", \"quality\": ";
+		WriteQualityJSON(out, result.quality);
+		out << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+	}
+	out << "  ]\n";
+	out << "}\n";
+	return out ? 1 : 0;
+}
+
+// Read the results written by WriteBenchmarkResults and summarize them per case, return false if the file cannot be read
+bool ReadBenchmarkBaseline(const std::string& path, std::map<std::string, BenchmarkSummary>& summaries)
+{
+	std::ifstream in(path);
+	if (!in)
+	{
+		std::cout << "The benchmark baseline file could not be opened successfully." << std::endl;
+		return false;
+	}
+
+	const std::string caseLabel = "{\"case\": \"";
+	std::string line;
+	while (std::getline(in, line))
+	{
+		std::size_t position = line.find(caseLabel);
+		if (position == std::string::npos)
+			continue;
+		position += caseLabel.size();
+		std::string caseID = line.substr(position, line.find('"', position) - position);
+		double wallSeconds = 0.0, averageQuality = 0.0;
+		if (ParseValueAfterLabel(line, "\"wallSeconds\": ", wallSeconds) && ParseValueAfterLabel(line, "\"averageQuality\": ", averageQuality))
+			summaries[caseID].Add(wallSeconds, averageQuality);
+	}
+	return true;
+}
+
+// Compare the results with the baseline and output one line per case, return the number of regressions
+int CompareWithBaseline(const std::map<std::string, BenchmarkSummary>& current, const std::map<std::string, BenchmarkSummary>& baseline, const RunOptions& options)
+{
+	int regressionCount = 0;
+	std::cout << "\nComparison with the baseline " << options.baselinePath << ":\n";
+	for (const auto& entry : current)
+	{
+		auto found = baseline.find(entry.first);
+		if (found == baseline.end())
+		{
+			std::cout << entry.first << ": not in the baseline" << std::endl;
+			continue;
+		}
+
+		const BenchmarkSummary& now = entry.second;
+		const BenchmarkSummary& before = found->second;
+		bool slower = now.bestWallSeconds > before.bestWallSeconds * (1.0 + options.tolerance);
+		bool worse = now.meanAverageQuality < before.meanAverageQuality - options.qualityTolerance;
+		std::cout << entry.first << ": " << before.bestWallSeconds << " s -> " << now.bestWallSeconds << " s, the average quality "
+			<< before.meanAverageQuality << " -> " << now.meanAverageQuality;
+		if (slower)
+			std::cout << " [TIME REGRESSION]";
+		if (worse)
+			std::cout << " [QUALITY REGRESSION]";
+		std::cout << std::endl;
+		if (slower || worse)
+			++regressionCount;
+	}
+
+	// A case of the baseline that produced no result is a regression as well
+	for (const auto& entry : baseline)
+	{
+		if (current.find(entry.first) == current.end())
+		{
+			std::cout << entry.first << ": no result [MISSING]" << std::endl;
+			++regressionCount;
+		}
+	}
+	return regressionCount;
+}
+
+// Run every benchmark case options.repeat times, write the results and compare them with the baseline.
+// Return 0 on success, 1 on an error or if a mesh could not be imported or its quality could not be read, and 2 if a
+// regression was found.
+int RunBenchmark(const RunOptions& options)
+{
+	int rank = 0, size = 1;
+#ifdef MSMPI
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	MPI_Comm_size(MPI_COMM_WORLD, &size);
 #endif // MSMPI
+
+	// Every process reads the case file, so that all of them run the same cases
+	std::vector<BenchmarkCase> cases;
+	if (!ReadBenchmarkCases(options.benchCasesPath, cases))
+		return 1;
+
+	std::vector<BenchmarkResult> results;
+	std::map<std::string, BenchmarkSummary> summaries;
+	int failedImportCount = 0;
+	int failedQualityCount = 0;
+	long long processPeakRSSBytes = PeakResidentSetSize();
+	for (const BenchmarkCase& benchmarkCase : cases)
+	{
+		// Write a missing synthetic mesh before the measured runs, a failure shows up as a failed import
+		if (rank == 0 && benchmarkCase.elementCount > 0 && !std::ifstream(MeshFilePath(benchmarkCase.folder, benchmarkCase.filename)))
+		{
+			RunOptions generateOptions;
+			generateOptions.generateFolder = benchmarkCase.folder;
+			generateOptions.generateFilename = benchmarkCase.filename;
+			generateOptions.format = benchmarkCase.format;
+			generateOptions.elementCount = benchmarkCase.elementCount;
+			GenerateSyntheticMesh(generateOptions);
+		}
+
+		for (int repeat = 0; repeat < options.repeat; ++repeat)
+		{
+			BenchmarkResult result;
+			result.repeat = repeat;
+			const int status = RunBenchmarkCase(benchmarkCase, rank, size, result);
+			if (status == 0)
+			{
+				if (rank == 0)
+					std::cout << benchmarkCase.ID(size) << ": the mesh could not be imported, skipped" << std::endl;
+				++failedImportCount;
+				break;
+			}
+			if (status == -1)
+			{
+				// Only rank 0 reads the quality, so the run is not recorded but the other processes keep in step
+				std::cout << result.caseID << " #" << repeat << ": the mesh quality could not be read, not recorded" << std::endl;
+				++failedQualityCount;
+				continue;
+			}
+			if (rank == 0)
+			{
+				processPeakRSSBytes = std::max(processPeakRSSBytes, std::max(result.peakRSSBytes, PeakResidentSetSize()));
+				std::cout << result.caseID << " #" << repeat << ": " << result.wallSeconds << " s, " << result.vertexUpdatesPerSecond
+					<< " vertex updates/s, the average quality is " << result.quality.averageQuality << std::endl;
+				results.push_back(result);
+				summaries[result.caseID].Add(result.wallSeconds, result.quality.averageQuality);
+			}
+		}
+	}
+	if (rank != 0)
+		return 0;
+
+	// Write the results and compare them with the baseline
+	if (WriteBenchmarkResults(results, size, processPeakRSSBytes, options.reportPath.empty() ? "benchmark.json" : options.reportPath) != 1)
+		return 1;
+	int regressionCount = 0;
+	if (!options.baselinePath.empty())
+	{
+		std::map<std::string, BenchmarkSummary> baseline;
+		if (!ReadBenchmarkBaseline(options.baselinePath, baseline))
+			return 1;
+		regressionCount = CompareWithBaseline(summaries, baseline, options);
+	}
+	if (failedImportCount > 0)
+		std::cout << failedImportCount << " benchmark case(s) could not be imported." << std::endl;
+	if (failedQualityCount > 0)
+		std::cout << failedQualityCount << " benchmark run(s) without a readable mesh quality." << std::endl;
+	if (failedImportCount > 0 || failedQualityCount > 0)
+		return 1;
+	return regressionCount > 0 ? 2 : 0;
 }
 
 int main(int argc, char* argv[])
@@ -132,14 +1105,31 @@ int main(int argc, char* argv[])
 #ifdef MSMPI // MSMPI optimization
 
 	MPI_Init(&argc, &argv);
-	MSMPIOpti();
+	int result = 0;
+	RunOptions options;
+	int rank = 0;
+	MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+	if (!ParseRunOptions(argc, argv, options))
+		result = 1;
+	else if (!options.generateFilename.empty())
+		result = rank == 0 ? GenerateSyntheticMesh(options) : 0;
+	else if (!options.benchCasesPath.empty())
+		result = RunBenchmark(options);
+	else
+		result = MSMPIOpti(options);
 	MPI_Finalize();
+	return result;
 
 #else // Normal single process optimization
 
-	GeneralOpti();
+	RunOptions options;
+	if (!ParseRunOptions(argc, argv, options))
+		return 1;
+	if (!options.generateFilename.empty())
+		return GenerateSyntheticMesh(options);
+	if (!options.benchCasesPath.empty())
+		return RunBenchmark(options);
+	return GeneralOpti(options);
 
 #endif // MSMPI
-
-	return 0;
 }
@@ -0,0 +1,238 @@
+#include "SyntheticMeshGenerator.h"
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <algorithm>
+
+namespace
+{
+// The six tetrahedra of a cube: the tetrahedron p walks from corner 0 to corner 7 along the axes kKuhnAxes[p][0],
+// kKuhnAxes[p][1] and kKuhnAxes[p][2]. Cube corners are numbered by the bits x = 1, y = 2, z = 4.
+const int kKuhnAxes[6][3] = {{0, 1, 2}, {1, 2, 0}, {2, 0, 1}, {0, 2, 1}, {2, 1, 0}, {1, 0, 2}};
+// Even permutations (the first three) leave d above the plane of a, b and c, so a and b are swapped for them
+const bool kSwapAB[6] = {true, true, true, false, false, false};
+
+// Number of attempts to find a valid offset for a vertex before it keeps its position
+const int kPerturbationAttempts = 4;
+
+// Uniform random double in [-1, 1) built from the raw generator output, which is identical on every platform
+double SignedUnitRandom(std::mt19937_64 &generator)
+{
+	return static_cast<double>(generator() >> 11) * (2.0 / 9007199254740992.0) - 1.0;
+}
+
+void AppendInteger(std::string &buffer, long long value)
+{
+	char digits[24];
+	int count = 0;
+	bool negative = value < 0;
+	unsigned long long magnitude = negative ? 0ULL - static_cast<unsigned long long>(value) : static_cast<unsigned long long>(value);
+	do
+	{
+		digits[count++] = static_cast<char>('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude != 0);
+	if (negative)
+		buffer.push_back('-');
+	while (count > 0)
+		buffer.push_back(digits[--count]);
+}
+
+void AppendDouble(std::string &buffer, double value)
+{
+	char text[32];
+	int length = std::snprintf(text, sizeof(text), "%.17g", value);
+	buffer.append(text, length);
+}
+} // namespace
+
+SyntheticMeshGenerator::SyntheticMeshGenerator(const long long &elementCount)
+{
+	// Use the smallest cube grid with at least elementCount tetrahedra
+	int n = static_cast<int>(std::ceil(std::cbrt(static_cast<double>(std::max(elementCount, 6LL)) / 6.0) - 1e-9));
+	nx_ = ny_ = nz_ = std::max(n, 1);
+	h_ = 1.0 / nx_;
+
+	coordinates_.resize(3 * VertexCount());
+	for (int k = 0; k <= nz_; ++k)
+		for (int j = 0; j <= ny_; ++j)
+			for (int i = 0; i <= nx_; ++i)
+			{
+				long long vertexID = (static_cast<long long>(k) * (ny_ + 1) + j) * (nx_ + 1) + i;
+				coordinates_[3 * vertexID] = i * h_;
+				coordinates_[3 * vertexID + 1] = j * h_;
+				coordinates_[3 * vertexID + 2] = k * h_;
+			}
+}
+
+long long SyntheticMeshGenerator::VertexCount() const
+{
+	return static_cast<long long>(nx_ + 1) * (ny_ + 1) * (nz_ + 1);
+}
+
+long long SyntheticMeshGenerator::ElementCount() const
+{
+	return 6LL * nx_ * ny_ * nz_;
+}
+
+void SyntheticMeshGenerator::PerturbInteriorVertices(const double &perturbation, const unsigned long long &seed)
+{
+	std::mt19937_64 generator(seed);
+	// Reject moves that shrink a mesh element below 1% of its unperturbed volume h^3 / 6
+	const double minVolume = 0.01 * h_ * h_ * h_ / 6.0;
+	for (int k = 1; k < nz_; ++k)
+		for (int j = 1; j < ny_; ++j)
+			for (int i = 1; i < nx_; ++i)
+			{
+				long long vertexID = (static_cast<long long>(k) * (ny_ + 1) + j) * (nx_ + 1) + i;
+				double *position = &coordinates_[3 * vertexID];
+				const double original[3] = {position[0], position[1], position[2]};
+				double amplitude = perturbation * h_;
+				for (int attempt = 0; attempt < kPerturbationAttempts; ++attempt, amplitude *= 0.5)
+				{
+					for (int axis = 0; axis < 3; ++axis)
+						position[axis] = original[axis] + amplitude * SignedUnitRandom(generator);
+					if (IsVertexBallValid(vertexID, minVolume))
+						break;
+					std::copy(original, original + 3, position);
+				}
+			}
+}
+
+void SyntheticMeshGenerator::GetElementVertices(const long long &elementID, long long vertexIDs[4]) const
+{
+	const int tetrahedron = static_cast<int>(elementID % 6);
+	long long cubeID = elementID / 6;
+	const int i = static_cast<int>(cubeID % nx_);
+	cubeID /= nx_;
+	const int j = static_cast<int>(cubeID % ny_);
+	const int k = static_cast<int>(cubeID / ny_);
+
+	// Walk from corner 0 to corner 7 of the cube
+	int corner[3] = {i, j, k};
+	for (int step = 0; step < 4; ++step)
+	{
+		if (step > 0)
+			++corner[kKuhnAxes[tetrahedron][step - 1]];
+		vertexIDs[step] = (static_cast<long long>(corner[2]) * (ny_ + 1) + corner[1]) * (nx_ + 1) + corner[0];
+	}
+	if (kSwapAB[tetrahedron])
+		std::swap(vertexIDs[0], vertexIDs[1]);
+}
+
+double SyntheticMeshGenerator::SignedVolume(const long long vertexIDs[4]) const
+{
+	const double *a = &coordinates_[3 * vertexIDs[0]];
+	const double *b = &coordinates_[3 * vertexIDs[1]];
+	const double *c = &coordinates_[3 * vertexIDs[2]];
+	const double *d = &coordinates_[3 * vertexIDs[3]];
+	const double ab[3] = {b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+	const double ac[3] = {c[0] - a[0], c[1] - a[1], c[2] - a[2]};
+	const double ad[3] = {d[0] - a[0], d[1] - a[1], d[2] - a[2]};
+	const double determinant = ab[0] * (ac[1] * ad[2] - ac[2] * ad[1]) - ab[1] * (ac[0] * ad[2] - ac[2] * ad[0]) + ab[2] * (ac[0] * ad[1] - ac[1] * ad[0]);
+	return -determinant / 6.0;
+}
+
+bool SyntheticMeshGenerator::IsVertexBallValid(const long long &vertexID, const double &minVolume) const
+{
+	const int i = static_cast<int>(vertexID % (nx_ + 1));
+	const int j = static_cast<int>(vertexID / (nx_ + 1) % (ny_ + 1));
+	const int k = static_cast<int>(vertexID / (static_cast<long long>(nx_ + 1) * (ny_ + 1)));
+
+	// The mesh elements including the vertex lie in the up to eight cubes around it
+	for (int ck = std::max(k - 1, 0); ck <= std::min(k, nz_ - 1); ++ck)
+		for (int cj = std::max(j - 1, 0); cj <= std::min(j, ny_ - 1); ++cj)
+			for (int ci = std::max(i - 1, 0); ci <= std::min(i, nx_ - 1); ++ci)
+			{
+				long long cubeID = (static_cast<long long>(ck) * ny_ + cj) * nx_ + ci;
+				for (int tetrahedron = 0; tetrahedron < 6; ++tetrahedron)
+				{
+					long long vertexIDs[4];
+					GetElementVertices(6 * cubeID + tetrahedron, vertexIDs);
+					if (std::find(vertexIDs, vertexIDs + 4, vertexID) != vertexIDs + 4 && SignedVolume(vertexIDs) < minVolume)
+						return false;
+				}
+			}
+	return true;
+}
+
+long long SyntheticMeshGenerator::FindElementOfVertex(const long long &vertexID) const
+{
+	const int i = static_cast<int>(vertexID % (nx_ + 1));
+	const int j = static_cast<int>(vertexID / (nx_ + 1) % (ny_ + 1));
+	const int k = static_cast<int>(vertexID / (static_cast<long long>(nx_ + 1) * (ny_ + 1)));
+
+	// Every vertex is a corner of the cube with the largest index not above its own
+	long long cubeID = (static_cast<long long>(std::min(k, nz_ - 1)) * ny_ + std::min(j, ny_ - 1)) * nx_ + std::min(i, nx_ - 1);
+	for (int tetrahedron = 0; tetrahedron < 6; ++tetrahedron)
+	{
+		long long vertexIDs[4];
+		GetElementVertices(6 * cubeID + tetrahedron, vertexIDs);
+		if (std::find(vertexIDs, vertexIDs + 4, vertexID) != vertexIDs + 4)
+			return 6 * cubeID + tetrahedron;
+	}
+	return -1;
+}
+
+int SyntheticMeshGenerator::ExportToTXT(const std::string &path, const bool &withMoreInfo) const
+{
+	std::ofstream out(path, std::ios::binary);
+	if (!out)
+		return 0;
+
+	// Format the file in large blocks instead of one stream insertion per value
+	const std::size_t blockSize = 1 << 22;
+	std::string buffer;
+	buffer.reserve(blockSize + 256);
+	auto flush = [&out, &buffer](const std::size_t &threshold) {
+		if (buffer.size() >= threshold)
+		{
+			out.write(buffer.data(), buffer.size());
+			buffer.clear();
+		}
+	};
+
+	// Vertices: x y z size boundaryFlag [regionID]
+	AppendInteger(buffer, VertexCount());
+	buffer.push_back('\n');
+	for (long long vertexID = 0; vertexID < VertexCount(); ++vertexID)
+	{
+		const int i = static_cast<int>(vertexID % (nx_ + 1));
+		const int j = static_cast<int>(vertexID / (nx_ + 1) % (ny_ + 1));
+		const int k = static_cast<int>(vertexID / (static_cast<long long>(nx_ + 1) * (ny_ + 1)));
+		const bool boundary = i == 0 || i == nx_ || j == 0 || j == ny_ || k == 0 || k == nz_;
+		for (int axis = 0; axis < 3; ++axis)
+		{
+			AppendDouble(buffer, coordinates_[3 * vertexID + axis]);
+			buffer.push_back(' ');
+		}
+		AppendDouble(buffer, h_);
+		buffer.append(boundary ? " 1" : " 0");
+		if (withMoreInfo)
+		{
+			buffer.push_back(' ');
+			AppendInteger(buffer, FindElementOfVertex(vertexID));
+		}
+		buffer.push_back('\n');
+		flush(blockSize);
+	}
+
+	// Mesh elements: aID bID cID dID
+	AppendInteger(buffer, ElementCount());
+	buffer.push_back('\n');
+	for (long long elementID = 0; elementID < ElementCount(); ++elementID)
+	{
+		long long vertexIDs[4];
+		GetElementVertices(elementID, vertexIDs);
+		for (int v = 0; v < 4; ++v)
+		{
+			AppendInteger(buffer, vertexIDs[v]);
+			buffer.push_back(v < 3 ? ' ' : '\n');
+		}
+		flush(blockSize);
+	}
+	flush(0);
+	return out ? 1 : 0;
+}
@@ -0,0 +1,86 @@
+// File Name: SyntheticMeshGenerator.h
+// Description: Synthetic tetrahedral mesh generator for scaling tests
+
+#ifndef EMMPMESH_EMESHOPTIMIZATIONTEST_SYNTHETICMESHGENERATOR_H_
+#define EMMPMESH_EMESHOPTIMIZATIONTEST_SYNTHETICMESHGENERATOR_H_
+
+#include <vector>
+#include <string>
+
+// Generates a tetrahedral mesh of the unit box. The box is divided into nx * ny * nz cubes and every cube is split into
+// six tetrahedra sharing its main diagonal (Kuhn subdivision), which gives a conforming mesh. Interior vertices are then
+// randomly perturbed to lower the mesh quality in a controlled way, boundary vertices stay on the box faces.
+class SyntheticMeshGenerator
+{
+private:
+    // Number of cubes along x, y and z
+    int nx_;
+    int ny_;
+    int nz_;
+    // Edge length of the cubes, also used as the size value of every vertex
+    double h_;
+    // Stores the 3D coordinates of all vertices as x, y, z triples. The vertex (i, j, k) of the cube grid has the ID
+    // (k * (ny_ + 1) + j) * (nx_ + 1) + i.
+    std::vector<double> coordinates_;
+
+public:
+    /************************************************************************
+     * Function Description: Constructor, places the vertices on the regular grid
+     * Input: Param elementCount: The requested number of mesh elements, rounded up to 6 * n^3 with n cubes per axis
+     * Return Value: None
+     ************************************************************************/
+    explicit SyntheticMeshGenerator(const long long &elementCount);
+
+    /************************************************************************
+     * Function Description: Randomly perturbs the interior vertices. Every vertex is moved by a uniform random offset of
+     *                       at most perturbation * h along each axis, a move that would invert or flatten one of its
+     *                       mesh elements is retried with a smaller offset and dropped after a few attempts.
+     * Input: Param perturbation: The maximum offset as a fraction of the cube edge length
+     *        Param seed: The seed of the random number generator, the same seed gives the same mesh on every platform
+     * Return Value: void
+     ************************************************************************/
+    void PerturbInteriorVertices(const double &perturbation, const unsigned long long &seed);
+
+    /************************************************************************
+     * Function Description: Exports the mesh in the TXT format read by EMeshOptimizationInitialMeshImportFromTXT, or by
+     *                       EMeshOptimizationInitialMeshImportFromTXTWithMoreInfo if withMoreInfo is true
+     * Input: Param path: The path of the output file
+     *        Param withMoreInfo: Whether the ID of a mesh element including the vertex is written for every vertex
+     * Return Value: 1 indicates file write success, 0 indicates failure
+     ************************************************************************/
+    int ExportToTXT(const std::string &path, const bool &withMoreInfo) const;
+
+    long long VertexCount() const;
+
+    long long ElementCount() const;
+
+private:
+    /************************************************************************
+     * Function Description: Gets the vertex IDs of a mesh element, ordered as described for vertexID_ in
+     *                       EMeshOptimization.h: d lies below the plane of a, b and c
+     * Input: Param elementID: The ID of the mesh element, 6 * cube ID + tetrahedron index within the cube
+     *        Param vertexIDs: Receives the four vertex IDs a, b, c and d
+     * Return Value: void
+     ************************************************************************/
+    void GetElementVertices(const long long &elementID, long long vertexIDs[4]) const;
+
+    /************************************************************************
+     * Function Description: Checks that every mesh element including the vertex keeps a volume of at least minVolume
+     * Input: Param vertexID: The ID of the vertex on the cube grid
+     *        Param minVolume: The smallest accepted volume
+     * Return Value: true if all mesh elements including the vertex are valid
+     ************************************************************************/
+    bool IsVertexBallValid(const long long &vertexID, const double &minVolume) const;
+
+    /************************************************************************
+     * Function Description: Finds the ID of any mesh element including the vertex
+     * Input: Param vertexID: The ID of the vertex on the cube grid
+     * Return Value: The ID of the mesh element
+     ************************************************************************/
+    long long FindElementOfVertex(const long long &vertexID) const;
+
+    // Signed volume of the mesh element, positive when d lies below the plane of a, b and c
+    double SignedVolume(const long long vertexIDs[4]) const;
+};
+
+#endif // EMMPMESH_EMESHOPTIMIZATIONTEST_SYNTHETICMESHGENERATOR_H_